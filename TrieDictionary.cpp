@@ -2,24 +2,134 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <map>
+#include <deque>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifdef _WIN32
+#include <io.h> // _commit
+#else
+#include <unistd.h> // fsync
+#endif
 #include <conio.h>
 
 using namespace std; // I used namespace std to avoid writing std:: before cout, cin, endl, etc.
-const int ALPHABET_SIZE = 26; // I used a constant for the alphabet size to make the code more readabl
 
+// Character-to-index table of an alphabet, -1 marks characters that are not part of the alphabet
+struct AlphabetTable
+{
+    signed char index[256];
+};
+
+// Builds the table at compile time from the ordered symbols of an alphabet (letters optionally match both cases)
+template <int N>
+constexpr AlphabetTable makeAlphabetTable(const char (&symbols)[N], bool foldCase)
+{
+    AlphabetTable table{};
+    for (int i = 0; i < 256; ++i)
+    {
+        table.index[i] = -1;
+    }
+    for (int i = 0; i < N - 1; ++i)
+    {
+        char ch = symbols[i];
+        table.index[static_cast<unsigned char>(ch)] = static_cast<signed char>(i);
+        if (foldCase && ch >= 'a' && ch <= 'z')
+        {
+            table.index[static_cast<unsigned char>(ch - 'a' + 'A')] = static_cast<signed char>(i);
+        }
+        else if (foldCase && ch >= 'A' && ch <= 'Z')
+        {
+            table.index[static_cast<unsigned char>(ch - 'A' + 'a')] = static_cast<signed char>(i);
+        }
+    }
+    return table;
+}
+
+// Alphabet policies used by TrieNode and Trie, each one gives the child width of a node,
+// the index of a character (a single table lookup) and the character stored at an index
+
+struct LowercaseAlphabet // Lowercase english letters, the alphabet of the dictionary
+{
+    static constexpr int size = 26;
+    static constexpr char symbols[size + 1] = "abcdefghijklmnopqrstuvwxyz";
+    static constexpr AlphabetTable table = makeAlphabetTable(symbols, false);
+
+    static int index(char ch) { return table.index[static_cast<unsigned char>(ch)]; }
+    static char symbol(int i) { return symbols[i]; }
+};
+
+struct CaseInsensitiveAlphabet // English letters where 'A' and 'a' share the same child
+{
+    static constexpr int size = 26;
+    static constexpr char symbols[size + 1] = "abcdefghijklmnopqrstuvwxyz";
+    static constexpr AlphabetTable table = makeAlphabetTable(symbols, true);
+
+    static int index(char ch) { return table.index[static_cast<unsigned char>(ch)]; }
+    static char symbol(int i) { return symbols[i]; }
+};
+
+struct AlphanumericAlphabet // Digits followed by lowercase letters, so words come out in ASCII order
+{
+    static constexpr int size = 36;
+    static constexpr char symbols[size + 1] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    static constexpr AlphabetTable table = makeAlphabetTable(symbols, false);
+
+    static int index(char ch) { return table.index[static_cast<unsigned char>(ch)]; }
+    static char symbol(int i) { return symbols[i]; }
+};
+
+struct NucleotideAlphabet // DNA bases for k-mer sets, lowercase bases are accepted too
+{
+    static constexpr int size = 4;
+    static constexpr char symbols[size + 1] = "ACGT";
+    static constexpr AlphabetTable table = makeAlphabetTable(symbols, true);
+
+    static int index(char ch) { return table.index[static_cast<unsigned char>(ch)]; }
+    static char symbol(int i) { return symbols[i]; }
+};
+
+// Out of class definitions of the constexpr members (needed before C++17)
+constexpr char LowercaseAlphabet::symbols[];
+constexpr AlphabetTable LowercaseAlphabet::table;
+constexpr char CaseInsensitiveAlphabet::symbols[];
+constexpr AlphabetTable CaseInsensitiveAlphabet::table;
+constexpr char AlphanumericAlphabet::symbols[];
+constexpr AlphabetTable AlphanumericAlphabet::table;
+constexpr char NucleotideAlphabet::symbols[];
+constexpr AlphabetTable NucleotideAlphabet::table;
+
+template <typename Alphabet = LowercaseAlphabet>
 class TrieNode // I used a class for the TrieNode to make the code more readable
 {
 public: // I used public access modifier to make the code more readable
 
-    TrieNode* children[ALPHABET_SIZE]; // I used an array of TrieNode pointers to store the children of a node
+    TrieNode* children[Alphabet::size]; // I used an array of TrieNode pointers sized exactly for the alphabet
 
     string meaning; // I used a string to store the meaning of a word
 
     bool isEndOfWord; // I used a boolean to mark the end of a word
 
+    TrieNode* fail; // Aho-Corasick failure link: node of the longest proper suffix that is also in the trie
+
+    TrieNode* output; // Aho-Corasick output link: nearest node on the failure chain that ends a word
+
+    int depth; // Length of the word spelled by the path to this node, set with the links
+
     TrieNode() // I used a constructor to initialize the TrieNode
     {
-        for (int i = 0; i < ALPHABET_SIZE; ++i) // I used a for loop to initialize the children of a node
+        for (int i = 0; i < Alphabet::size; ++i) // I used a for loop to initialize the children of a node
         {
             children[i] = nullptr; // I used nullptr to initialize the children of a node
         }
@@ -27,135 +137,1187 @@ public: // I used public access modifier to make the code more readable
         meaning = ""; // I used an empty string to initialize the meaning of a word
 
         isEndOfWord = false; // I used false to initialize the end of a word
+
+        fail = nullptr; // The links are filled in by Trie::buildAutomaton
+
+        output = nullptr;
+
+        depth = 0;
+    }
+};
+
+template <typename Alphabet>
+class DoubleArrayTrie;
+
+template <typename Alphabet = LowercaseAlphabet>
+class Trie
+{
+public:
+    typedef TrieNode<Alphabet> Node; // The node type of this alphabet
+
+private: // I used private access modifier to make the code more readable
+    Node* root; // I used a TrieNode pointer to store the root node
+
+    bool automatonBuilt; // False when the failure and output links are out of date
+
+    int maxDepth; // Length of the longest word, set by buildAutomaton
+
+public:
+    Trie() // I used a constructor to initialize the Trie
+    {
+        root = new Node(); // I used new to initialize the root node
+        automatonBuilt = false;
+        maxDepth = 0;
+    }
+
+    void insert(const string& word, const string& meaning) // Insert a word into the trie
+    {
+        Node* current = root; // Start from the root node
+        automatonBuilt = false; // New nodes have no failure links yet
+
+        for (int i = 0; i < word.length(); ++i)// Traverse the trie
+        {
+            int index = Alphabet::index(word[i]); // Get the index of the character
+            if (index < 0) // Skip spaces and other characters outside the alphabet
+                continue;
+
+            if (!current->children[index]) // If the character is not found 
+            {
+                current->children[index] = new Node(); // Create a new node
+            }
+            current = current->children[index]; // Move to the next node
+        }
+        current->meaning = meaning; // Set the meaning of the word
+
+        current->isEndOfWord = true; // Mark the end of the word
+    }
+
+    void deletenode(string& word, string& meaning) {
+        Node* current = root; // Start from the root node
+        Node* parent = nullptr; // Keep track of the parent node
+        int lastIndex = -1; // Child slot of 'current' inside 'parent'
+
+        for (int i = 0; i < word.length(); ++i) {
+            int index = Alphabet::index(word[i]);
+            if (index < 0) // Skipped by insert, so skipped here too
+                continue;
+
+            if (!current->children[index]) {
+                // The character is not found, the word might not exist
+                cout << "Word not found in the trie." << endl;
+                return;
+            }
+
+            parent = current;
+            current = current->children[index];
+            lastIndex = index;
+        }
+
+        // At this point, 'current' points to the node representing the last character of the word
+        if (current->isEndOfWord) {
+            // If the word exists, mark it as not the end of the word and set an empty meaning
+            current->isEndOfWord = false;
+            current->meaning = " ";
+        }
+        else {
+            // The word doesn't exist in the trie
+            cout << "Word not found in the trie." << endl;
+            return;
+        }
+
+        // Check if the node has no children (i.e., it's not part of any other words)
+        bool hasChildren = false;
+        for (int i = 0; i < Alphabet::size; ++i) {
+            if (current->children[i]) {
+                hasChildren = true;
+                break;
+            }
+        }
+
+        // If the node has no children, it can be safely deleted
+        if (!hasChildren) {
+            automatonBuilt = false; // Failure links may point to the deleted node
+            delete current;
+            // Remove the link from the parent if parent is not null
+            if (parent) {
+                parent->children[lastIndex] = nullptr;
+            }
+        }
+    }
+
+
+
+    bool search(const string& word, string& meaning) const
+    {
+        const Node* node = searchNode(word); // Search for the word in the trie
+        if (node && node->isEndOfWord) // If the word is found and it is the end of a word
+        {
+            meaning = node->meaning; // Get the meaning of the word
+
+            return true; // Word found
+        }
+        return false; // Word not found
+    }
+
+    Node* getRoot() const { // Getter for the root node
+
+        return root; // Return the root node
+    }
+
+    Node* searchNode(const string& word) const { // Search for a word in the trie
+
+        Node* current = root; // Start from the root node
+        for (int i = 0; i < word.length(); ++i) // Traverse the trie
+        {
+            int index = Alphabet::index(word[i]); // Get the index of the character
+            if (index < 0) // Skipped by insert, so skipped here too
+                continue;
+
+            if (!current->children[index]) // If the character is not found
+            {
+                return nullptr; // Return null
+            }
+            current = current->children[index]; // Move to the next node
+        }
+        return current; // Return the node
+    }
+
+    // Collects up to 'limit' words starting with 'prefix' in alphabetical order
+    void collectWords(const string& prefix, vector<string>& words, size_t limit) const
+    {
+        const Node* node = searchNode(prefix); // Find the node of the prefix
+        if (node)
+        {
+            string word = prefix;
+            collectWords(node, word, words, limit);
+        }
+    }
+
+    // Memory used by the nodes of the trie (meaning text not included)
+    size_t memoryUsage() const
+    {
+        return countNodes(root) * sizeof(Node);
+    }
+
+    // Converts the trie into a read-only double-array trie, defined after DoubleArrayTrie
+    DoubleArrayTrie<Alphabet> freeze() const;
+
+    // Adds failure and output links to every node so the trie can be used as an Aho-Corasick automaton
+    void buildAutomaton()
+    {
+        vector<Node*> order; // Nodes in breadth first order, a node's failure target is always shallower
+        order.push_back(root);
+        root->fail = nullptr;
+        root->output = nullptr;
+        root->depth = 0;
+        maxDepth = 0;
+
+        for (size_t next = 0; next < order.size(); ++next)
+        {
+            Node* node = order[next];
+            for (int i = 0; i < Alphabet::size; ++i)
+            {
+                Node* child = node->children[i];
+                if (!child)
+                    continue;
+
+                child->depth = node->depth + 1;
+                maxDepth = max(maxDepth, child->depth);
+
+                Node* fail = node->fail; // Longest suffix of the parent that can be extended by the same character
+                while (fail && !fail->children[i])
+                {
+                    fail = fail->fail;
+                }
+                child->fail = fail ? fail->children[i] : root;
+                child->output = child->fail->isEndOfWord ? child->fail : child->fail->output;
+                order.push_back(child);
+            }
+        }
+        automatonBuilt = true;
+    }
+
+    // Streams a file through the automaton in a single pass and calls onMatch(offset, word) for every
+    // occurrence of a word, letters are matched case-insensitively like transformToLowercase.
+    // With 'longestOnly' only the leftmost-longest non-overlapping matches are reported (a segmentation of the text).
+    // Returns the number of bytes scanned, or -1 if the file cannot be opened.
+    template <typename OnMatch>
+    long long scanFile(const string& filename, OnMatch onMatch, bool longestOnly)
+    {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open())
+            return -1;
+
+        if (!automatonBuilt)
+            buildAutomaton();
+
+        int fold[256]; // Index of each byte, uppercase letters use the index of their lowercase letter
+        for (int c = 0; c < 256; ++c)
+        {
+            fold[c] = Alphabet::index(static_cast<char>(c));
+            if (fold[c] < 0)
+                fold[c] = Alphabet::index(static_cast<char>(tolower(c)));
+        }
+
+        // The last 'maxDepth' bytes of each block are kept in front of the next one so matches
+        // crossing a block boundary can still be spelled out
+        const size_t BLOCK_SIZE = 4 << 20;
+        const size_t keepMax = static_cast<size_t>(maxDepth);
+        vector<char> buffer(keepMax + BLOCK_SIZE);
+        size_t kept = 0;
+        long long bufferOffset = 0; // File offset of buffer[0]
+        long long scanned = 0;
+
+        string word;
+        auto emit = [&](long long start, int length)
+        {
+            const char* text = buffer.data() + (start - bufferOffset);
+            word.resize(length);
+            for (int i = 0; i < length; ++i)
+            {
+                word[i] = Alphabet::symbol(fold[static_cast<unsigned char>(text[i])]);
+            }
+            onMatch(start, word);
+        };
+
+        map<long long, int> candidates; // Longest match per start offset not yet reported (longestOnly mode)
+        long long reportedEnd = -1; // Last offset covered by a reported match (longestOnly mode)
+        auto reportBefore = [&](long long boundary) // Reports the candidates no future match can start before
+        {
+            while (!candidates.empty() && candidates.begin()->first < boundary)
+            {
+                long long start = candidates.begin()->first;
+                int length = candidates.begin()->second;
+                emit(start, length);
+                reportedEnd = start + length - 1;
+                while (!candidates.empty() && candidates.begin()->first <= reportedEnd)
+                {
+                    candidates.erase(candidates.begin());
+                }
+            }
+        };
+
+        Node* state = root;
+        while (file)
+        {
+            file.read(buffer.data() + kept, BLOCK_SIZE);
+            size_t got = static_cast<size_t>(file.gcount());
+            if (got == 0)
+                break;
+
+            size_t end = kept + got;
+            for (size_t i = kept; i < end; ++i)
+            {
+                int index = fold[static_cast<unsigned char>(buffer[i])];
+                if (index < 0) // Characters outside the alphabet end every partial match
+                {
+                    state = root;
+                }
+                else
+                {
+                    while (state != root && !state->children[index])
+                    {
+                        state = state->fail;
+                    }
+                    state = state->children[index] ? state->children[index] : root;
+                }
+
+                long long position = bufferOffset + static_cast<long long>(i);
+                for (Node* match = state; match; match = match->output) // Longest match first
+                {
+                    if (!match->isEndOfWord || match->depth == 0) // Words deleted after the build stay on the chain
+                        continue;
+
+                    long long start = position - match->depth + 1;
+                    if (!longestOnly)
+                    {
+                        emit(start, match->depth);
+                    }
+                    else if (start > reportedEnd)
+                    {
+                        int& length = candidates[start];
+                        length = max(length, match->depth);
+                    }
+                }
+                if (longestOnly)
+                {
+                    reportBefore(position - state->depth + 1);
+                }
+            }
+
+            size_t keep = min(end, keepMax);
+            memmove(buffer.data(), buffer.data() + end - keep, keep);
+            bufferOffset += static_cast<long long>(end - keep);
+            kept = keep;
+            scanned += static_cast<long long>(got);
+        }
+
+        if (longestOnly)
+        {
+            reportBefore(bufferOffset + static_cast<long long>(kept) + 1);
+        }
+        return scanned;
+    }
+
+private:
+    void collectWords(const Node* node, string& word, vector<string>& words, size_t limit) const
+    {
+        if (words.size() >= limit)
+            return;
+
+        if (node->isEndOfWord)
+        {
+            words.push_back(word);
+        }
+
+        for (int i = 0; i < Alphabet::size; ++i) // Visit the children in alphabetical order
+        {
+            if (node->children[i])
+            {
+                word.push_back(Alphabet::symbol(i));
+                collectWords(node->children[i], word, words, limit);
+                word.pop_back();
+            }
+        }
+    }
+
+    size_t countNodes(const Node* node) const
+    {
+        size_t count = 1;
+        for (int i = 0; i < Alphabet::size; ++i)
+        {
+            if (node->children[i])
+            {
+                count += countNodes(node->children[i]);
+            }
+        }
+        return count;
+    }
+};
+
+// Read-only double-array trie made by Trie::freeze().
+// The child of state s for character index c lives at slot t = BASE[s] + c and is valid only when CHECK[t] == s,
+// so every transition is one array index plus one equality check instead of a pointer dereference.
+template <typename Alphabet = LowercaseAlphabet>
+class DoubleArrayTrie
+{
+private:
+    enum { FREE = -1, ROOT = 0 }; // CHECK value of an unused slot and state of the root node
+
+    vector<int> base; // BASE array
+    vector<int> check; // CHECK array, holds the parent state of each used slot
+    vector<int> value; // Index into 'meanings' for states that end a word, -1 otherwise
+    vector<string> meanings; // Meanings of the stored words
+
+    friend class Trie<Alphabet>;
+
+    // Returns the child state, or -1 if there is none. The arrays are padded by Alphabet::size slots so no bounds check is needed
+    int child(int state, int index) const
+    {
+        int next = base[state] + index;
+        return check[next] == state ? next : -1;
+    }
+
+    int findState(const string& word) const
+    {
+        int state = ROOT;
+        for (size_t i = 0; i < word.length() && state >= 0; ++i)
+        {
+            int index = Alphabet::index(word[i]);
+            if (index >= 0) // Characters outside the alphabet are skipped like in Trie::searchNode
+                state = child(state, index);
+        }
+        return state;
+    }
+
+    void collectWords(int state, string& word, vector<string>& words, size_t limit) const
+    {
+        if (words.size() >= limit)
+            return;
+
+        if (value[state] >= 0)
+        {
+            words.push_back(word);
+        }
+
+        for (int i = 0; i < Alphabet::size; ++i) // Same alphabetical order as the pointer trie
+        {
+            int next = child(state, i);
+            if (next >= 0)
+            {
+                word.push_back(Alphabet::symbol(i));
+                collectWords(next, word, words, limit);
+                word.pop_back();
+            }
+        }
+    }
+
+    // Grows the arrays so that 'slot' plus the padding of one full alphabet is addressable
+    void reserveSlot(int slot)
+    {
+        size_t needed = static_cast<size_t>(slot) + Alphabet::size + 1;
+        if (needed > check.size())
+        {
+            size_t newSize = max(needed, check.size() * 2);
+            base.resize(newSize, 0);
+            check.resize(newSize, FREE);
+            value.resize(newSize, -1);
+        }
+    }
+
+public:
+    bool search(const string& word, string& meaning) const
+    {
+        int state = findState(word);
+        if (state >= 0 && value[state] >= 0)
+        {
+            meaning = meanings[value[state]];
+            return true;
+        }
+        return false;
+    }
+
+    // Collects up to 'limit' words starting with 'prefix', same results as Trie::collectWords
+    void collectWords(const string& prefix, vector<string>& words, size_t limit) const
+    {
+        int state = findState(prefix);
+        if (state >= 0)
+        {
+            string word = prefix;
+            collectWords(state, word, words, limit);
+        }
+    }
+
+    // Memory used by the arrays (meaning text not included)
+    size_t memoryUsage() const
+    {
+        return (base.size() + check.size() + value.size()) * sizeof(int) + meanings.size() * sizeof(string);
+    }
+};
+
+template <typename Alphabet>
+DoubleArrayTrie<Alphabet> Trie<Alphabet>::freeze() const
+{
+    typedef DoubleArrayTrie<Alphabet> Frozen;
+    Frozen frozen;
+    frozen.reserveSlot(Frozen::ROOT);
+    frozen.check[Frozen::ROOT] = -2; // The root slot is used but has no parent
+
+    vector<pair<const Node*, int> > pending; // Nodes whose children still have to be placed, with their state
+    pending.push_back(make_pair(root, Frozen::ROOT));
+    int firstFree = 1; // Every slot below this one is used
+    int lastUsed = Frozen::ROOT;
+
+    for (size_t next = 0; next < pending.size(); ++next) // Breadth first over the pointer trie
+    {
+        const Node* node = pending[next].first;
+        int state = pending[next].second;
+
+        if (node->isEndOfWord)
+        {
+            frozen.value[state] = static_cast<int>(frozen.meanings.size());
+            frozen.meanings.push_back(node->meaning);
+        }
+
+        int indexes[Alphabet::size];
+        int count = 0;
+        for (int i = 0; i < Alphabet::size; ++i)
+        {
+            if (node->children[i])
+            {
+                indexes[count++] = i;
+            }
+        }
+        if (count == 0)
+            continue; // Leaves keep BASE 0, their CHECK can never match
+
+        while (frozen.check[firstFree] != Frozen::FREE)
+        {
+            ++firstFree;
+            frozen.reserveSlot(firstFree);
+        }
+
+        // Find the smallest BASE (at least 1) whose slots are all free for the children of this node
+        int baseValue = max(1, firstFree - indexes[0]);
+        while (true)
+        {
+            frozen.reserveSlot(baseValue + indexes[count - 1]);
+            bool fits = true;
+            for (int i = 0; i < count && fits; ++i)
+            {
+                fits = frozen.check[baseValue + indexes[i]] == Frozen::FREE;
+            }
+            if (fits)
+                break;
+            ++baseValue;
+        }
+
+        frozen.base[state] = baseValue;
+        for (int i = 0; i < count; ++i)
+        {
+            int slot = baseValue + indexes[i];
+            frozen.check[slot] = state;
+            lastUsed = max(lastUsed, slot);
+            pending.push_back(make_pair(node->children[indexes[i]], slot));
+        }
+    }
+
+    // Drop the unused tail but keep one alphabet of padding for the unchecked transitions
+    size_t finalSize = static_cast<size_t>(lastUsed) + Alphabet::size + 1;
+    frozen.base.resize(finalSize);
+    frozen.check.resize(finalSize);
+    frozen.value.resize(finalSize);
+    frozen.base.shrink_to_fit();
+    frozen.check.shrink_to_fit();
+    frozen.value.shrink_to_fit();
+    return frozen;
+}
+
+// Appends dictionary records to a file on a background thread.
+// Callers only copy the record into a buffer, the thread writes everything queued since its last pass
+// with one buffered write and syncs the file to disk at most once per 'syncInterval' (or on flush()).
+// Records that fail to reach the disk are queued again and retried, a retry may append a record twice
+// which is harmless because loading the same word again keeps the same meaning.
+class PersistenceWriter
+{
+private:
+    string filename; // File the records are appended to
+    chrono::milliseconds syncInterval; // How often written records are synced to disk, and how often a failure is retried
+
+    mutex lock; // Guards everything below except 'unsynced' and 'file'
+    condition_variable wakeWriter; // Signals the thread that there is work
+    condition_variable wakeWaiters; // Signals flush() callers that records became durable or that an attempt failed
+    string pending; // Records queued and not written yet
+    unsigned long long queued; // Number of records queued so far
+    unsigned long long synced; // Number of records synced to disk
+    unsigned long long flushTarget; // Records that a flush() caller waits for
+    unsigned long long failures; // Number of failed write or sync attempts
+    bool retrying; // The last attempt failed, wait 'syncInterval' before the next one unless a flush() asks
+    bool stopping; // Set by the destructor
+
+    string unsynced; // Records written since the last successful sync, owned by the thread
+    FILE* file; // Open while there are unsynced records, owned by the thread
+    thread worker;
+
+    static const size_t BUFFER_SIZE = 1 << 20; // Size of the stdio buffer of the file
+
+    void run()
+    {
+        chrono::steady_clock::time_point lastAttempt = chrono::steady_clock::now(); // Last sync or failed attempt
+        unique_lock<mutex> guard(lock);
+
+        while (true)
+        {
+            bool dirty = queued > synced;
+            if (!dirty && stopping)
+                break;
+
+            bool urgent = flushTarget > synced || stopping;
+            bool due = chrono::steady_clock::now() - lastAttempt >= syncInterval;
+            bool canWrite = !pending.empty() && (!retrying || urgent || due);
+            bool mustSync = dirty && (urgent || due);
+            if (!canWrite && !mustSync)
+            {
+                if (dirty) // Sleep until the next sync or retry is due
+                    wakeWriter.wait_until(guard, lastAttempt + syncInterval);
+                else
+                    wakeWriter.wait(guard);
+                continue;
+            }
+
+            // Take everything queued so far and write it with the lock released
+            string batch;
+            batch.swap(pending);
+            unsigned long long batchEnd = queued;
+            guard.unlock();
+
+            bool saved = writeBatch(batch);
+            if (saved && mustSync)
+            {
+                saved = syncFile();
+            }
+            if (mustSync || !saved)
+            {
+                lastAttempt = chrono::steady_clock::now();
+            }
+
+            guard.lock();
+            if (!saved) // Queue everything that is not known to be on disk again, in front of the newer records
+            {
+                pending.insert(0, unsynced);
+                unsynced.clear();
+                ++failures;
+                retrying = true;
+                flushTarget = synced; // The waiting flush() calls report the failure, they do not force more retries
+                wakeWaiters.notify_all();
+                if (stopping)
+                {
+                    cerr << "ERROR SAVING DICTIONARY FILE: " << queued - synced << " WORDS WERE NOT SAVED." << endl;
+                    break;
+                }
+            }
+            else if (mustSync)
+            {
+                synced = batchEnd;
+                retrying = false;
+                wakeWaiters.notify_all();
+            }
+        }
+    }
+
+    bool writeBatch(const string& batch)
+    {
+        if (batch.empty())
+            return true;
+
+        unsynced += batch; // Kept until synced so a failed open, write or sync can be retried in full
+        if (!file)
+        {
+            file = fopen(filename.c_str(), "ab"); // Open the file for appending to avoid overwriting the existing content
+            if (!file)
+                return false;
+            setvbuf(file, nullptr, _IOFBF, BUFFER_SIZE);
+        }
+        if (fwrite(batch.data(), 1, batch.size(), file) != batch.size())
+        {
+            fclose(file);
+            file = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    // Pushes the buffered records to disk and closes the file so it can be rewritten or replaced
+    bool syncFile()
+    {
+        if (!file)
+            return true;
+
+        bool saved = fflush(file) == 0;
+#ifdef _WIN32
+        saved = saved && _commit(_fileno(file)) == 0;
+#else
+        saved = saved && fsync(fileno(file)) == 0;
+#endif
+        saved = fclose(file) == 0 && saved;
+        file = nullptr;
+        if (saved)
+        {
+            unsynced.clear();
+        }
+        return saved;
+    }
+
+public:
+    PersistenceWriter(const string& filename, chrono::milliseconds syncInterval = chrono::milliseconds(1000))
+        : filename(filename), syncInterval(syncInterval), queued(0), synced(0), flushTarget(0), failures(0),
+        retrying(false), stopping(false), file(nullptr)
+    {
+        worker = thread(&PersistenceWriter::run, this);
+    }
+
+    ~PersistenceWriter()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wakeWriter.notify_one();
+        worker.join(); // The thread makes one last attempt to save everything still queued before it exits
+    }
+
+    // Queues a record, the caller never waits for the disk
+    void append(const string& record)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            pending += record;
+            ++queued;
+        }
+        wakeWriter.notify_one();
+    }
+
+    // Durability barrier: returns true once every record queued before the call is synced to disk and the file is closed,
+    // or false if the attempt to save them failed (the records stay queued and are retried later)
+    bool flush()
+    {
+        unique_lock<mutex> guard(lock);
+        unsigned long long target = queued;
+        unsigned long long failuresBefore = failures;
+        if (synced >= target)
+            return true;
+
+        flushTarget = max(flushTarget, target);
+        wakeWriter.notify_one();
+        wakeWaiters.wait(guard, [this, target, failuresBefore] { return synced >= target || failures > failuresBefore; });
+        return synced >= target;
+    }
+};
+
+// Queue shared by the stages of the spell-check pipeline, push() blocks while it is full so a fast stage
+// cannot run ahead of a slow one, pop() returns false once the queue is closed and empty
+template <typename T>
+class BoundedQueue
+{
+private:
+    deque<T> items;
+    size_t capacity;
+    bool closed;
+    mutex lock;
+    condition_variable notEmpty;
+    condition_variable notFull;
+
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity), closed(false)
+    {
+    }
+
+    void push(T item)
+    {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this] { return items.size() < capacity; });
+        items.push_back(move(item));
+        notEmpty.notify_one();
+    }
+
+    bool pop(T& item)
+    {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this] { return !items.empty() || closed; });
+        if (items.empty())
+            return false;
+
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() // No more items will be pushed
+    {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+    }
+};
+
+// A word of a checked document that is not in the dictionary
+struct SpellingMiss
+{
+    long long offset; // Byte offset of the word in the document
+    string word; // The word in lowercase
+    vector<string> suggestions; // Dictionary words sharing the longest prefix with it
+};
+
+// Counters of one spell-check run
+struct SpellCheckStats
+{
+    long long bytes;
+    long long words;
+    long long misses;
+};
+
+// Spell-checks a document with a pipeline of threads: a reader streams the file in blocks, a tokenizer splits
+// the blocks into lowercase words and worker threads look the words up in the trie. Results are handed back
+// in document order on the calling thread. The trie must not be changed while a check is running.
+template <typename Alphabet = LowercaseAlphabet>
+class SpellCheckPipeline
+{
+private:
+    struct Token
+    {
+        long long offset;
+        string word;
+    };
+
+    struct Block // Raw text, never splits a word
+    {
+        long long sequence;
+        long long offset;
+        string text;
+    };
+
+    struct Batch // Words of one block
+    {
+        long long sequence;
+        vector<Token> tokens;
+    };
+
+    struct Result // Misses of one batch
+    {
+        long long sequence;
+        long long words;
+        vector<SpellingMiss> misses;
+    };
+
+    static const size_t BLOCK_SIZE = 256 * 1024;
+
+    const Trie<Alphabet>& trie;
+    int workerCount;
+    int suggestionCount;
+
+    // Reorder window: the tokenizer may not run more than 'window' blocks ahead of the oldest unreported one
+    mutex windowLock;
+    condition_variable windowMoved;
+    long long reported;
+    long long window;
+
+    // Words are runs of characters of the alphabet, uppercase letters count as their lowercase letter
+    static bool isWordCharacter(char ch)
+    {
+        return Alphabet::index(ch) >= 0 || Alphabet::index(static_cast<char>(tolower(static_cast<unsigned char>(ch)))) >= 0;
+    }
+
+    void readBlocks(ifstream& file, BoundedQueue<Block>& blocks, long long& bytes)
+    {
+        string carry; // Start of a word cut by the end of the previous block
+        long long offset = 0;
+        long long sequence = 0;
+        vector<char> buffer(BLOCK_SIZE);
+
+        while (file)
+        {
+            file.read(buffer.data(), buffer.size());
+            size_t got = static_cast<size_t>(file.gcount());
+            if (got == 0)
+                break;
+            bytes += static_cast<long long>(got);
+
+            Block block;
+            block.offset = offset;
+            block.text.swap(carry);
+            block.text.append(buffer.data(), got);
+
+            size_t cut = block.text.size(); // Keep a trailing partial word for the next block
+            while (cut > 0 && isWordCharacter(block.text[cut - 1]))
+            {
+                --cut;
+            }
+            if (!file.eof())
+            {
+                carry.assign(block.text, cut, string::npos);
+                block.text.resize(cut);
+                if (block.text.empty()) // The whole block is one word, read on until it ends
+                    continue;
+            }
+            block.sequence = sequence++;
+            offset += static_cast<long long>(block.text.size());
+            blocks.push(move(block));
+        }
+        if (!carry.empty())
+        {
+            Block block;
+            block.sequence = sequence;
+            block.offset = offset;
+            block.text.swap(carry);
+            blocks.push(move(block));
+        }
+        blocks.close();
+    }
+
+    void tokenize(BoundedQueue<Block>& blocks, BoundedQueue<Batch>& batches)
+    {
+        Block block;
+        while (blocks.pop(block))
+        {
+            Batch batch;
+            batch.sequence = block.sequence;
+            const string& text = block.text;
+            for (size_t i = 0; i < text.size();)
+            {
+                if (!isWordCharacter(text[i]))
+                {
+                    ++i;
+                    continue;
+                }
+                Token token;
+                token.offset = block.offset + static_cast<long long>(i);
+                for (; i < text.size() && isWordCharacter(text[i]); ++i)
+                {
+                    token.word.push_back(static_cast<char>(tolower(text[i]))); // Lowercase like transformToLowercase
+                }
+                batch.tokens.push_back(move(token));
+            }
+            {
+                unique_lock<mutex> guard(windowLock);
+                windowMoved.wait(guard, [this, &batch] { return batch.sequence < reported + window; });
+            }
+            batches.push(move(batch));
+        }
+        batches.close();
+    }
+
+    void check(BoundedQueue<Batch>& batches, BoundedQueue<Result>& results, atomic<int>& running)
+    {
+        Batch batch;
+        string meaning;
+        while (batches.pop(batch))
+        {
+            Result result;
+            result.sequence = batch.sequence;
+            result.words = static_cast<long long>(batch.tokens.size());
+            for (size_t i = 0; i < batch.tokens.size(); ++i)
+            {
+                Token& token = batch.tokens[i];
+                if (trie.search(token.word, meaning))
+                    continue;
+
+                SpellingMiss miss;
+                miss.offset = token.offset;
+                miss.word = move(token.word);
+                suggest(miss.word, miss.suggestions);
+                result.misses.push_back(move(miss));
+            }
+            results.push(move(result));
+        }
+        if (--running == 0) // The last worker ends the result stream
+        {
+            results.close();
+        }
+    }
+
+    // Suggestions are the first words under the longest prefix of 'word' that is in the trie
+    void suggest(const string& word, vector<string>& suggestions) const
+    {
+        size_t length = word.size();
+        while (length > 0 && !trie.searchNode(word.substr(0, length)))
+        {
+            --length;
+        }
+        if (length > 0)
+        {
+            trie.collectWords(word.substr(0, length), suggestions, suggestionCount);
+        }
+    }
+
+public:
+    SpellCheckPipeline(const Trie<Alphabet>& trie, int workerCount, int suggestionCount = 3)
+        : trie(trie), workerCount(max(workerCount, 1)), suggestionCount(suggestionCount), reported(0), window(0)
+    {
+    }
+
+    // Checks 'filename' and calls onMiss(miss) for every unknown word in document order.
+    // Returns false if the file cannot be opened.
+    template <typename OnMiss>
+    bool run(const string& filename, OnMiss onMiss, SpellCheckStats& stats)
+    {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open())
+            return false;
+
+        stats.bytes = 0;
+        stats.words = 0;
+        stats.misses = 0;
+
+        size_t depth = static_cast<size_t>(workerCount) * 2; // Blocks in flight between two stages
+        reported = 0;
+        window = static_cast<long long>(depth) * 4;
+        BoundedQueue<Block> blocks(depth);
+        BoundedQueue<Batch> batches(depth);
+        BoundedQueue<Result> results(depth);
+        atomic<int> running(workerCount);
+
+        thread reader(&SpellCheckPipeline::readBlocks, this, ref(file), ref(blocks), ref(stats.bytes));
+        thread tokenizer(&SpellCheckPipeline::tokenize, this, ref(blocks), ref(batches));
+        vector<thread> workers;
+        for (int i = 0; i < workerCount; ++i)
+        {
+            workers.push_back(thread(&SpellCheckPipeline::check, this, ref(batches), ref(results), ref(running)));
+        }
+
+        // Workers finish out of order, hold early results until every earlier block is reported.
+        // The reorder window keeps this map below 'window' entries.
+        map<long long, Result> early;
+        long long next = 0;
+        Result result;
+        while (results.pop(result))
+        {
+            early[result.sequence] = move(result);
+            for (auto it = early.begin(); it != early.end() && it->first == next; it = early.erase(it))
+            {
+                {
+                    lock_guard<mutex> guard(windowLock);
+                    reported = ++next;
+                }
+                windowMoved.notify_one();
+
+                stats.words += it->second.words;
+                stats.misses += static_cast<long long>(it->second.misses.size());
+                for (size_t i = 0; i < it->second.misses.size(); ++i)
+                {
+                    onMiss(it->second.misses[i]);
+                }
+            }
+        }
+
+        reader.join();
+        tokenizer.join();
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            workers[i].join();
+        }
+        return true;
     }
 };
 
-class Trie
+// Bounded LRU cache of query results in front of the trie. Entries are spread over shards with their own
+// lock and LRU list, so the capacity is split evenly and threads rarely wait for each other.
+// A query is a kind (LOOKUP of a word or PREFIX suggestions) plus the queried text.
+class QueryCache
 {
-private: // I used private access modifier to make the code more readable
-    TrieNode* root; // I used a TrieNode pointer to store the root node
-
 public:
-    Trie() // I used a constructor to initialize the Trie
+    enum Kind { LOOKUP = 'W', PREFIX = 'P' };
+
+    struct Entry // Cached result of one query
     {
-        root = new TrieNode(); // I used new to initialize the root node
-    }
+        bool found;
+        vector<string> values; // The meaning of a word, or the suggestion lines of a prefix
+    };
 
-    void insert(const string& word, const string& meaning) // Insert a word into the trie
+private:
+    typedef list<pair<string, Entry> > EntryList; // Most recently used first
+
+    struct Shard
     {
-        TrieNode* current = root; // Start from the root node
+        mutex lock;
+        EntryList entries;
+        unordered_map<string, EntryList::iterator> index;
+    };
 
-        for (int i = 0; i < word.length(); ++i)// Traverse the trie
-        {
-            char ch = word[i]; // Get the current character
-            if (ch == ' ')
-                continue;
+    vector<Shard> shards;
+    size_t shardCapacity; // Entries kept per shard
 
-            int index = ch - 'a'; // Get the index of the character
-            if (!current->children[index]) // If the character is not found 
-            {
-                current->children[index] = new TrieNode(); // Create a new node
-            }
-            current = current->children[index]; // Move to the next node
-        }
-        current->meaning = meaning; // Set the meaning of the word
+    atomic<unsigned long long> hits;
+    atomic<unsigned long long> misses;
+    atomic<unsigned long long> evictions;
+    atomic<unsigned long long> invalidations;
 
-        current->isEndOfWord = true; // Mark the end of the word
+    static string makeKey(Kind kind, const string& query)
+    {
+        return static_cast<char>(kind) + query;
     }
 
-    void deletenode(string& word, string& meaning) {
-        TrieNode* current = root; // Start from the root node
-        TrieNode* parent = nullptr; // Keep track of the parent node
+    Shard& shardOf(const string& key)
+    {
+        return shards[hash<string>()(key) % shards.size()];
+    }
 
-        for (int i = 0; i < word.length(); ++i) {
-            char ch = word[i];
-            int index = ch - 'a';
+    void erase(const string& key)
+    {
+        Shard& shard = shardOf(key);
+        lock_guard<mutex> guard(shard.lock);
+        unordered_map<string, EntryList::iterator>::iterator found = shard.index.find(key);
+        if (found != shard.index.end())
+        {
+            shard.entries.erase(found->second);
+            shard.index.erase(found);
+            ++invalidations;
+        }
+    }
 
-            if (!current->children[index]) {
-                // The character is not found, the word might not exist
-                cout << "Word not found in the trie." << endl;
-                return;
-            }
+public:
+    QueryCache(size_t capacity, size_t shardCount)
+        : shards(max<size_t>(shardCount, 1)), hits(0), misses(0), evictions(0), invalidations(0)
+    {
+        shardCapacity = max<size_t>((capacity + shards.size() - 1) / shards.size(), 1);
+    }
 
-            parent = current;
-            current = current->children[index];
+    bool get(Kind kind, const string& query, Entry& entry)
+    {
+        string key = makeKey(kind, query);
+        Shard& shard = shardOf(key);
+        lock_guard<mutex> guard(shard.lock);
+        unordered_map<string, EntryList::iterator>::iterator found = shard.index.find(key);
+        if (found == shard.index.end())
+        {
+            ++misses;
+            return false;
         }
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second); // Mark as most recently used
+        entry = found->second->second;
+        ++hits;
+        return true;
+    }
 
-        // At this point, 'current' points to the node representing the last character of the word
-        if (current->isEndOfWord) {
-            // If the word exists, mark it as not the end of the word and set an empty meaning
-            current->isEndOfWord = false;
-            current->meaning = " ";
-        }
-        else {
-            // The word doesn't exist in the trie
-            cout << "Word not found in the trie." << endl;
+    void put(Kind kind, const string& query, const Entry& entry)
+    {
+        string key = makeKey(kind, query);
+        Shard& shard = shardOf(key);
+        lock_guard<mutex> guard(shard.lock);
+        unordered_map<string, EntryList::iterator>::iterator found = shard.index.find(key);
+        if (found != shard.index.end())
+        {
+            found->second->second = entry;
+            shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
             return;
         }
-
-        // Check if the node has no children (i.e., it's not part of any other words)
-        bool hasChildren = false;
-        for (int i = 0; i < 26; ++i) {
-            if (current->children[i]) {
-                hasChildren = true;
-                break;
-            }
-        }
-
-        // If the node has no children, it can be safely deleted
-        if (!hasChildren) {
-            delete current;
-            // Remove the link from the parent if parent is not null
-            if (parent) {
-                parent->children[word.back() - 'a'] = nullptr;
-            }
+        if (shard.entries.size() >= shardCapacity) // Evict the least recently used entry
+        {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+            ++evictions;
         }
+        shard.entries.push_front(make_pair(key, entry));
+        shard.index[key] = shard.entries.begin();
     }
 
-
-
-    bool search(const string& word, string& meaning) const
+    // Drops every entry a change to 'word' can affect: the lookup of the word and the suggestions of each of its prefixes.
+    // Queries must be cached under the same keys as the words (see Dictionary::transformToKey).
+    void invalidateWord(const string& word)
     {
-        const TrieNode* node = searchNode(word); // Search for the word in the trie
-        if (node && node->isEndOfWord) // If the word is found and it is the end of a word
+        erase(makeKey(LOOKUP, word));
+        for (size_t length = 0; length <= word.size(); ++length)
         {
-            meaning = node->meaning; // Get the meaning of the word
-
-            return true; // Word found
+            erase(makeKey(PREFIX, word.substr(0, length)));
         }
-        return false; // Word not found
     }
 
-    TrieNode* getRoot() const { // Getter for the root node
-
-        return root; // Return the root node
+    void clear()
+    {
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            lock_guard<mutex> guard(shards[i].lock);
+            shards[i].entries.clear();
+            shards[i].index.clear();
+        }
     }
 
-    TrieNode* searchNode(const string& word) const { // Search for a word in the trie
-
-        TrieNode* current = root; // Start from the root node
-        for (int i = 0; i < word.length(); ++i) // Traverse the trie
+    size_t size()
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < shards.size(); ++i)
         {
-            char ch = word[i]; // Get the current character
-            int index = ch - 'a'; // Get the index of the character
-
-            if (!current->children[index]) // If the character is not found
-            {
-                return nullptr; // Return null
-            }
-            current = current->children[index]; // Move to the next node
+            lock_guard<mutex> guard(shards[i].lock);
+            total += shards[i].entries.size();
         }
-        return current; // Return the node
+        return total;
     }
+
+    size_t capacity() const { return shardCapacity * shards.size(); }
+    unsigned long long hitCount() const { return hits; }
+    unsigned long long missCount() const { return misses; }
+    unsigned long long evictionCount() const { return evictions; }
+    unsigned long long invalidationCount() const { return invalidations; }
 };
 
 class Dictionary  // I used a class for the Dictionary to make the code more readable
 {
 private:
+    typedef LowercaseAlphabet Alphabet; // The dictionary stores lowercase english words
+    typedef Trie<Alphabet> DictionaryTrie;
+    typedef TrieNode<Alphabet> Node;
+
+    DictionaryTrie trie; // I used a Trie to store the words and meanings
 
-    Trie trie; // I used a Trie to store the words and meanings
+    PersistenceWriter writer; // I used a background writer so adding words never waits for the disk
+
+    QueryCache cache; // I used a cache so the most frequent lookups and suggestions are not recomputed
 
 public:
+    Dictionary() : writer("dictionary.txt"), cache(4096, 16)
+    {
+    }
+
     bool isLoaded = false; // I used a boolean to check if the dictionary is loaded
 
     // Function to load words and meanings from a file into the dictionary
@@ -191,6 +1353,7 @@ public:
                     trie.insert(lowercaseWord, meaning); // Insert the word and the meaning into the trie
                 }
             }
+            cache.clear(); // Results cached before loading are out of date
             cout << endl << "\t      DICTIONARY LOADED SUCCESSFULLY." << endl;
             cout << "\n\t    |====================================================================|\n\n";
             isLoaded = true; // Set the flag to true after loading
@@ -220,28 +1383,19 @@ public:
         else
         {
             trie.insert(lowercaseWord, meaning);
+            cache.invalidateWord(transformToKey(lowercaseWord));
             cout << "Word added successfully." << endl;
-            // Append the new word and meaning to the "dictionary.txt" file
-            ofstream dictionaryFile("dictionary.txt", ios::app);
-
-            // Open the file for appending (ios::app) to avoid overwriting the existing content of the file
-            if (dictionaryFile.is_open())
-            {
-                dictionaryFile << "\n" << lowercaseWord << "\t" << meaning << "\n";
-                dictionaryFile.close();
-                cout << "Word added to the dictionary file." << endl;
-            }
-            else
-            {
-                cerr << "Error opening dictionary file for appending." << endl;
-            }
+            // Queue the new word and meaning for the "dictionary.txt" file
+            writer.append("\n" + lowercaseWord + "\t" + meaning + "\n");
+            cout << "Word queued for the dictionary file." << endl;
         }
     }
 
 
 
-    void deleteWorddic(string filename, string& key)
+    void deleteWorddic(string filename, const string& input)
     {
+        string key = transformToLowercase(input); // Words are stored in lowercase
         char cho;
         while (true)
         {
@@ -264,14 +1418,16 @@ public:
                 return;
             }
         }
-        TrieNode* current = trie.getRoot(); // Start from the root node
+        Node* current = trie.getRoot(); // Start from the root node
         bool found = 1;
         string del;
 
         for (int i = 0; i < key.length(); ++i) // Traverse the trie
         {
-            char ch = key[i]; // Get the current character
-            int index = ch - 'a'; // Get the index of the character
+            int index = Alphabet::index(key[i]); // Get the index of the character
+            if (index < 0) // Skipped by insert, so skipped here too
+                continue;
+
             if (!current->children[index]) // If the character is not found
             {
                 found = 0;
@@ -282,10 +1438,17 @@ public:
 
         if (found == 1 && current->isEndOfWord) // If the word is found and it is the end of a word
         {
+            if (!writer.flush()) // Queued words must be in the file before it is rewritten
+            {
+                cout << endl << "\t      ERROR SAVING QUEUED WORDS. THE WORD WAS NOT DELETED." << endl << endl;
+                return;
+            }
+
             del = "";
             cout << "\n\t    |====================================================================|\n";
             current->meaning = del;
             current->isEndOfWord = 0;
+            cache.invalidateWord(transformToKey(key));
 
             cout << "\n\t      Deleting word from dictionary... Please wait..." << endl;
             cout << "\n\t    |====================================================================|\n";
@@ -359,14 +1522,14 @@ public:
 
     // This function explores the Trie to find and collect suggestions for words related to a given partial term.
 // It starts from the provided TrieNode and recursively traverses the Trie, collecting suggestions in the 'suggestions' array.
-    void exploreSuggestions(TrieNode* node, const string& partialTerm, string suggestions[], int& count) {
+    void exploreSuggestions(Node* node, const string& partialTerm, string suggestions[], int& count) {
         if (node->isEndOfWord && count < 10) {
             suggestions[count++] = "Word: " + partialTerm + "\t\t\t| Meaning: " + node->meaning;
         }
 
-        for (int i = 0; i < 26; ++i) {
+        for (int i = 0; i < Alphabet::size; ++i) {
             if (node->children[i]) {
-                char ch = static_cast<char>('a' + i);
+                char ch = Alphabet::symbol(i);
                 exploreSuggestions(node->children[i], partialTerm + ch, suggestions, count);
             }
         }
@@ -375,13 +1538,42 @@ public:
     // This function suggests related terms based on a partial term provided by the user.
     // It traverses the Trie to find the node corresponding to the last character of the partial term,
     // and then calls exploreSuggestions to gather related term suggestions.
-    void suggestRelatedTerms(const Trie& termTrie, string& partialTerm) {
-        TrieNode* current = termTrie.getRoot();
+    // The suggestions of the dictionary's own trie are served from the cache when possible.
+    void suggestRelatedTerms(const DictionaryTrie& termTrie, string& partialTerm) {
+        string key = transformToKey(partialTerm); // Every spelling of the same prefix shares one cache entry
+        QueryCache::Entry suggestions;
+        bool cacheable = &termTrie == &trie;
+        if (!cacheable || !cache.get(QueryCache::PREFIX, key, suggestions))
+        {
+            suggestions.found = findSuggestions(termTrie, key, suggestions.values);
+            if (cacheable)
+            {
+                cache.put(QueryCache::PREFIX, key, suggestions);
+            }
+        }
+
+        if (!suggestions.found) {
+            cout << "WORD NOT FOUND" << endl;
+            return;
+        }
+
+        cout << endl << "\t\tSUGGESTIONS : " << endl << endl;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            cout << "\t\t " << (i < suggestions.values.size() ? suggestions.values[i] : "") << endl;
+        }
+    }
+
+    // Collects up to 10 suggestion lines for a partial term, returns false if no word starts with it.
+    bool findSuggestions(const DictionaryTrie& termTrie, const string& partialTerm, vector<string>& lines) {
+        Node* current = termTrie.getRoot();
         for (char character : partialTerm) {
-            int index = character - 'a';
+            int index = Alphabet::index(character);
+            if (index < 0) // Skipped by insert, so skipped here too
+                continue;
+
             if (!current->children[index]) {
-                cout << "WORD NOT FOUND" << endl;
-                return;
+                return false;
             }
             current = current->children[index];
         }
@@ -390,17 +1582,15 @@ public:
         int count = 0;
 
         exploreSuggestions(current, partialTerm, termSuggestions, count);
-        cout << endl << "\t\tSUGGESTIONS : " << endl << endl;
-        for (int i = 0; i < 10; ++i)
-        {
-            cout << "\t\t " << termSuggestions[i] << endl;
-        }
+        lines.assign(termSuggestions, termSuggestions + count);
+        return true;
     }
 
     // This function updates the meaning of a word in the dictionary Trie.
     // It takes a filename and a key (word) to search for in the Trie and update its meaning.
     void updateDictionary(const string& filename, string key)
     {
+        key = transformToLowercase(key); // Words are stored in lowercase
         string update;
         if (!isLoaded)
         { // Check if the dictionary is already loaded
@@ -408,13 +1598,15 @@ public:
             return;
         }
 
-        TrieNode* current = trie.getRoot(); // Start from the root node
+        Node* current = trie.getRoot(); // Start from the root node
         bool found = 1;
 
         for (int i = 0; i < key.length(); ++i) // Traverse the trie
         {
-            char ch = key[i]; // Get the current character
-            int index = ch - 'a'; // Get the index of the character
+            int index = Alphabet::index(key[i]); // Get the index of the character
+            if (index < 0) // Skipped by insert, so skipped here too
+                continue;
+
             if (!current->children[index]) // If the character is not found
             {
                 found = 0;
@@ -431,6 +1623,7 @@ public:
             cin >> update;
             cout << "\n\t    |====================================================================|\n";
             current->meaning = update;
+            cache.invalidateWord(transformToKey(key));
 
             cout << "\n\t      Updating dictionary... Please wait..." << endl;
             cout << "\n\t    |====================================================================|\n";
@@ -478,20 +1671,12 @@ public:
         else
         {
             trie.insert(lowercaseWord, meaning);
+            cache.invalidateWord(transformToKey(lowercaseWord));
             cout << "\n\t\tWORD ADDED SUCCESSFULLY." << endl;
 
-            // Append the new word and meaning to the "dictionary.txt" file
-            ofstream dictionaryFile("dictionary.txt", ios::app);
-            if (dictionaryFile.is_open())
-            {
-                dictionaryFile << lowercaseWord << "\t" << meaning << "\n";
-                dictionaryFile.close();
-                cout << "\n\t\tWORD ADDED TO THE DICTIONARY FILE." << endl;
-            }
-            else
-            {
-                cerr << "ERROR OPENING DICTIONARY FILE FOR APPENDING." << endl;
-            }
+            // Queue the new word and meaning for the "dictionary.txt" file
+            writer.append(lowercaseWord + "\t" + meaning + "\n");
+            cout << "\n\t\tWORD QUEUED FOR THE DICTIONARY FILE." << endl;
             cout << "\t    |====================================================================|\n";
         }
     }
@@ -502,10 +1687,24 @@ public:
         // Convert the search term to lowercase
         string lowercaseWord = transformToLowercase(word);
 
-        // Search for the word in the trie
+        // Search for the word in the cache first, then in the trie
         string meaning;
+        string key = transformToKey(lowercaseWord); // Every spelling of the same word shares one cache entry
+        QueryCache::Entry lookup;
+
+        if (cache.get(QueryCache::LOOKUP, key, lookup))
+        {
+            if (lookup.found)
+                meaning = lookup.values[0];
+        }
+        else
+        {
+            lookup.found = trie.search(lowercaseWord, meaning);
+            lookup.values.assign(1, meaning);
+            cache.put(QueryCache::LOOKUP, key, lookup);
+        }
 
-        if (trie.search(lowercaseWord, meaning))
+        if (lookup.found)
         {
             char cho;
             while (1)
@@ -584,9 +1783,171 @@ public:
         }
     }
 
+    // Function to freeze the dictionary into a double-array trie and compare it with the pointer trie
+    void BenchmarkFrozenDictionary()
+    {
+        typedef chrono::steady_clock Clock;
+
+        cout << "\n\t    |====================================================================|\n\n";
+        cout << "\t      Freezing dictionary... Please wait..." << endl;
+
+        Clock::time_point start = Clock::now();
+        DoubleArrayTrie<Alphabet> frozen = trie.freeze();
+        double freezeMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+        vector<string> words;
+        trie.collectWords("", words, static_cast<size_t>(-1)); // Every word in alphabetical order
+
+        // Both representations must give the same lookups and the same ordered suggestions
+        size_t mismatches = 0;
+        vector<string> expected, actual;
+        for (size_t i = 0; i < words.size(); ++i)
+        {
+            string meaning, frozenMeaning;
+            if (!trie.search(words[i], meaning) || !frozen.search(words[i], frozenMeaning) || meaning != frozenMeaning)
+            {
+                ++mismatches;
+            }
+            string prefix = words[i].substr(0, 2);
+            expected.clear();
+            actual.clear();
+            trie.collectWords(prefix, expected, 10);
+            frozen.collectWords(prefix, actual, 10);
+            if (expected != actual)
+            {
+                ++mismatches;
+            }
+        }
+
+        // Time the lookups in a random order so both tries pay for cache misses
+        vector<string> queries = words;
+        shuffle(queries.begin(), queries.end(), mt19937(42));
+        const int rounds = 5;
+        size_t hits = 0;
+        string meaning;
+
+        start = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                hits += trie.search(queries[i], meaning);
+            }
+        }
+        double pointerNs = chrono::duration<double, nano>(Clock::now() - start).count();
+
+        start = Clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                hits += frozen.search(queries[i], meaning);
+            }
+        }
+        double frozenNs = chrono::duration<double, nano>(Clock::now() - start).count();
+
+        double lookups = static_cast<double>(rounds) * max<size_t>(queries.size(), 1);
+        cout << "\n\t      WORDS                : " << words.size() << endl;
+        cout << "\t      FREEZE TIME          : " << freezeMs << " ms" << endl;
+        cout << "\t      MISMATCHES           : " << mismatches << endl;
+        cout << "\t      POINTER TRIE LOOKUP  : " << pointerNs / lookups << " ns, " << trie.memoryUsage() / 1024 << " KB" << endl;
+        cout << "\t      DOUBLE-ARRAY LOOKUP  : " << frozenNs / lookups << " ns, " << frozen.memoryUsage() / 1024 << " KB" << endl;
+        cout << "\t      (" << hits << " hits)" << endl;
+        cout << "\n\t    |====================================================================|\n\n";
+    }
+
+    // Function to find every dictionary word in a text file and write "offset<TAB>word" lines to 'outputName'
+    void ScanFile(const string& filename, const string& outputName, bool longestOnly)
+    {
+        ofstream output(outputName);
+        if (!output.is_open())
+        {
+            cerr << "ERROR OPENING OUTPUT FILE: " << outputName << endl;
+            return;
+        }
+
+        cout << "\n\t    |====================================================================|\n\n";
+        cout << "\t      Scanning file... Please wait..." << endl;
+
+        unsigned long long matches = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        long long bytes = trie.scanFile(filename, [&](long long offset, const string& word)
+            {
+                output << offset << '\t' << word << '\n';
+                ++matches;
+            }, longestOnly);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (bytes < 0)
+        {
+            cout << endl << "\t      ERROR OPENING FILE: " << filename << endl;
+            return;
+        }
+
+        cout << "\n\t      BYTES SCANNED : " << bytes << endl;
+        cout << "\t      MATCHES       : " << matches << " (saved to " << outputName << ")" << endl;
+        cout << "\t      THROUGHPUT    : " << (seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0) << " MB/s" << endl;
+        cout << "\n\t    |====================================================================|\n\n";
+    }
+
+    // Function to spell-check a document on all cores and write "offset<TAB>word<TAB>suggestions" lines to 'outputName'
+    void CheckDocument(const string& filename, const string& outputName)
+    {
+        ofstream output(outputName);
+        if (!output.is_open())
+        {
+            cerr << "ERROR OPENING OUTPUT FILE: " << outputName << endl;
+            return;
+        }
+
+        cout << "\n\t    |====================================================================|\n\n";
+        cout << "\t      Checking document... Please wait..." << endl;
+
+        SpellCheckPipeline<Alphabet> pipeline(trie, static_cast<int>(thread::hardware_concurrency()));
+        SpellCheckStats stats;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        bool opened = pipeline.run(filename, [&](const SpellingMiss& miss)
+            {
+                output << miss.offset << '\t' << miss.word << '\t';
+                for (size_t i = 0; i < miss.suggestions.size(); ++i)
+                {
+                    output << (i ? "," : "") << miss.suggestions[i];
+                }
+                output << '\n';
+            }, stats);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (!opened)
+        {
+            cout << endl << "\t      ERROR OPENING FILE: " << filename << endl;
+            return;
+        }
+
+        cout << "\n\t      WORDS CHECKED : " << stats.words << endl;
+        cout << "\t      MISSPELLED    : " << stats.misses << " (saved to " << outputName << ")" << endl;
+        cout << "\t      THROUGHPUT    : " << (seconds > 0 ? stats.bytes / (1024.0 * 1024.0) / seconds : 0) << " MB/s" << endl;
+        cout << "\n\t    |====================================================================|\n\n";
+    }
+
+    // Function to show how well the query cache works, to tune its size against real traffic
+    void ShowCacheStatistics()
+    {
+        unsigned long long hits = cache.hitCount();
+        unsigned long long misses = cache.missCount();
+
+        cout << "\n\t    |====================================================================|\n\n";
+        cout << "\t      CACHED QUERIES : " << cache.size() << " / " << cache.capacity() << endl;
+        cout << "\t      HITS           : " << hits << endl;
+        cout << "\t      MISSES         : " << misses << endl;
+        cout << "\t      HIT RATE       : " << (hits + misses ? 100.0 * hits / (hits + misses) : 0) << " %" << endl;
+        cout << "\t      EVICTIONS      : " << cache.evictionCount() << endl;
+        cout << "\t      INVALIDATIONS  : " << cache.invalidationCount() << endl;
+        cout << "\n\t    |====================================================================|\n\n";
+    }
+
 private:
     // Display words using Trie traversal
-    void displayTrieWords(const Trie& trie, const TrieNode* node = nullptr, string currentWord = "") const
+    void displayTrieWords(const DictionaryTrie& trie, const Node* node = nullptr, string currentWord = "") const
     {
         if (!node) // If the node is null, start from the root node
         {
@@ -598,11 +1959,11 @@ private:
             cout << "\n\t\tWord: " << currentWord << "\t\t\t| Meaning: " << node->meaning << endl; // Display the word and the meaning
         }
 
-        for (int i = 0; i < ALPHABET_SIZE; ++i) // Traverse the trie
+        for (int i = 0; i < Alphabet::size; ++i) // Traverse the trie
         {
             if (node->children[i]) // If the child is not null
             {
-                char ch = 'a' + i; // Get the character
+                char ch = Alphabet::symbol(i); // Get the character
                 displayTrieWords(trie, node->children[i], currentWord + ch); // Recursively display the words
 
             }
@@ -619,6 +1980,19 @@ private:
         }
         return result; // Return the result
     }
+
+    // Function to transform a word into the key the trie keeps it under: lowercase, without the characters insert skips
+    string transformToKey(const string& str) const
+    {
+        string lowercase = transformToLowercase(str);
+        string result;
+        for (size_t i = 0; i < lowercase.length(); ++i)
+        {
+            if (Alphabet::index(lowercase[i]) >= 0)
+                result.push_back(lowercase[i]);
+        }
+        return result;
+    }
 };
 
 int main()
@@ -649,13 +2023,21 @@ int main()
         cout << "\t      |=====================================|\n";
         cout << "\t\tPRESS 6 TO UPDATE A WORD\n";
         cout << "\t      |=====================================|\n";
+        cout << "\t\tPRESS 7 TO BENCHMARK FROZEN DICTIONARY\n";
+        cout << "\t      |=====================================|\n";
+        cout << "\t\tPRESS 8 TO SCAN A TEXT FILE FOR WORDS\n";
+        cout << "\t      |=====================================|\n";
+        cout << "\t\tPRESS 9 TO SPELL-CHECK A DOCUMENT\n";
+        cout << "\t      |=====================================|\n";
+        cout << "\t\tPRESS C TO SEE CACHE STATISTICS\n";
+        cout << "\t      |=====================================|\n";
 
         cout << "\n\t\tPRESS Esc TO END PROGRAM\n\n";
 
         cout << "\t      |=====================================|\n";
         cout << "\t\tPRESS 0 TO SEE CREDITS OF DICTIONARY\n";
         cout << "\t      |=====================================|\n";
-        cout << "\n\t\tPRESS 1,2,3,4,5,6 OR Esc TO PERFORM FUNCTIONS\n";
+        cout << "\n\t\tPRESS 1,2,3,4,5,6,7,8,9,C OR Esc TO PERFORM FUNCTIONS\n";
         choice = _getch();
 
         switch (choice)
@@ -753,6 +2135,64 @@ int main()
             system("pause");
             break;
 
+        case '7':
+            system("cls");
+            system("Color 4f");
+
+            if (!myDictionary.isLoaded) {
+                cout << "DICTIONARY NOT LOADED. PLEASE LOAD THE DICTIONARY FIRST." << endl;
+                break;
+            }
+            myDictionary.BenchmarkFrozenDictionary();
+            system("pause");
+            break;
+
+        case '8':
+            system("cls");
+            system("Color 2F");
+
+            if (!myDictionary.isLoaded) {
+                cout << "DICTIONARY NOT LOADED. PLEASE LOAD THE DICTIONARY FIRST." << endl;
+                break;
+            }
+            cout << "\t    |====================================================================|\n";
+            cout << "\n\t\tSCAN A TEXT FILE\n";
+            cout << "\t\t----------------\n";
+            cout << "\t\tENTER THE FILE TO SCAN: ";
+            getline(cin >> ws, word); // Read the file name including whitespaces
+            cout << "\t\tL: Longest Matches Only\tA: All Matches ";
+            go = _getch();
+            myDictionary.ScanFile(word, "matches.txt", go == 'L' || go == 'l');
+            go = '0';
+            system("pause");
+            break;
+
+        case '9':
+            system("cls");
+            system("Color 5F");
+
+            if (!myDictionary.isLoaded) {
+                cout << "DICTIONARY NOT LOADED. PLEASE LOAD THE DICTIONARY FIRST." << endl;
+                break;
+            }
+            cout << "\t    |====================================================================|\n";
+            cout << "\n\t\tSPELL-CHECK A DOCUMENT\n";
+            cout << "\t\t----------------\n";
+            cout << "\t\tENTER THE DOCUMENT TO CHECK: ";
+            getline(cin >> ws, word); // Read the file name including whitespaces
+            myDictionary.CheckDocument(word, "misspelled.txt");
+            system("pause");
+            break;
+
+        case 'C':
+        case 'c':
+            system("cls");
+            system("Color 8F");
+
+            myDictionary.ShowCacheStatistics();
+            system("pause");
+            break;
+
         case '0':
             system("cls");
             system("Color 8F");